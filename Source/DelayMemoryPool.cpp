@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+    DelayMemoryPool.cpp
+    Created: 18 Oct 2026
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "DelayMemoryPool.h"
+
+//==============================================================================
+DelayMemoryPool::DelayMemoryPool()
+	: juce::Thread("Delay memory pool")
+{
+	for (auto& slab : m_slabs)
+	{
+		for (auto& state : slab.state)
+			state.store(Locked);
+	}
+
+	for (int sizeClass = 0; sizeClass < N_SIZE_CLASSES; sizeClass++)
+	{
+		m_waiting[sizeClass].store(0);
+		m_taken[sizeClass].store(0);
+	}
+
+	startThread();
+}
+
+DelayMemoryPool::~DelayMemoryPool()
+{
+	stopThread(1000);
+}
+
+int DelayMemoryPool::GetClassSize(int sizeClass)
+{
+	// Four steps per octave keep the rounding waste below 25 %
+	return (MIN_BLOCK_SIZE << (sizeClass / 4)) / 4 * (4 + sizeClass % 4);
+}
+
+int DelayMemoryPool::GetSizeClass(int size)
+{
+	for (int sizeClass = 0; sizeClass < N_SIZE_CLASSES; sizeClass++)
+	{
+		if (GetClassSize(sizeClass) >= size)
+			return sizeClass;
+	}
+
+	jassertfalse;
+	return -1;
+}
+
+int DelayMemoryPool::Allocate(int size)
+{
+	const int sizeClass = GetSizeClass(size);
+	if (sizeClass < 0)
+		return -1;
+
+	const juce::ScopedLock sl(m_lock);
+
+	// Keeps spares of this class reserved while it is in use, and for a while after
+	m_spareTicks[sizeClass] = SPARE_TIMEOUT_MS / FILL_INTERVAL_MS;
+
+	const int block = TakeBlock(sizeClass);
+	return block >= 0 ? block : AllocateSlab(sizeClass, true);
+}
+
+int DelayMemoryPool::Acquire(int size)
+{
+	const int sizeClass = GetSizeClass(size);
+	if (sizeClass < 0)
+		return -1;
+
+	return TakeBlock(sizeClass);
+}
+
+void DelayMemoryPool::CountMissedBlock()
+{
+	m_missedBlocks++;
+}
+
+void DelayMemoryPool::Wait(int size)
+{
+	const int sizeClass = GetSizeClass(size);
+	if (sizeClass >= 0)
+		m_waiting[sizeClass]++;
+}
+
+void DelayMemoryPool::StopWaiting(int size)
+{
+	const int sizeClass = GetSizeClass(size);
+	if (sizeClass >= 0)
+		m_waiting[sizeClass]--;
+}
+
+int DelayMemoryPool::TakeBlock(int sizeClass)
+{
+	for (int i = 0; i < MAX_SLABS; i++)
+	{
+		auto& slab = m_slabs[i];
+
+		if (slab.sizeClass.load() != sizeClass)
+			continue;
+
+		for (int block = 0; block < BLOCKS_PER_SLAB; block++)
+		{
+			int expected = Free;
+			if (!slab.state[block].compare_exchange_strong(expected, InUse))
+				continue;
+
+			// The slab may have been trimmed and reused for another class since its class was read
+			if (slab.sizeClass.load() == sizeClass)
+			{
+				m_taken[sizeClass]++;
+				return i * BLOCKS_PER_SLAB + block;
+			}
+
+			slab.state[block].store(Free);
+		}
+	}
+
+	return -1;
+}
+
+void DelayMemoryPool::Release(int block)
+{
+	// Free right away, so it can serve as a spare before the pool thread trims it
+	m_slabs[block / BLOCKS_PER_SLAB].state[block % BLOCKS_PER_SLAB].store(Free);
+}
+
+float* DelayMemoryPool::GetData(int block) const
+{
+	const auto& slab = m_slabs[block / BLOCKS_PER_SLAB];
+	return slab.data.get() + (size_t)(block % BLOCKS_PER_SLAB) * (size_t)GetClassSize(slab.sizeClass.load());
+}
+
+DelayMemoryPool::Occupancy DelayMemoryPool::GetOccupancy() const
+{
+	Occupancy occupancy;
+	occupancy.missedBlocks = m_missedBlocks.load();
+
+	for (const auto& waiting : m_waiting)
+		occupancy.waiting += waiting.load();
+
+	for (const auto& slab : m_slabs)
+	{
+		const int sizeClass = slab.sizeClass.load();
+		if (sizeClass < 0)
+			continue;
+
+		occupancy.slabs++;
+		occupancy.blocks += BLOCKS_PER_SLAB;
+		occupancy.bytes += (juce::int64)GetClassSize(sizeClass) * BLOCKS_PER_SLAB * (juce::int64)sizeof(float);
+
+		for (const auto& state : slab.state)
+		{
+			if (state.load() == InUse)
+				occupancy.inUse++;
+		}
+	}
+
+	return occupancy;
+}
+
+int DelayMemoryPool::AllocateSlab(int sizeClass, bool claimFirst)
+{
+	const juce::ScopedLock sl(m_lock);
+
+	for (int i = 0; i < MAX_SLABS; i++)
+	{
+		auto& slab = m_slabs[i];
+
+		if (slab.sizeClass.load() >= 0)
+			continue;
+
+		// Writing the whole slab faults its pages in here, not on the audio thread
+		const size_t slabSize = (size_t)GetClassSize(sizeClass) * BLOCKS_PER_SLAB;
+		slab.data.malloc(slabSize);
+		juce::zeromem(slab.data.get(), slabSize * sizeof(float));
+		slab.sizeClass.store(sizeClass);
+
+		for (int block = 0; block < BLOCKS_PER_SLAB; block++)
+			slab.state[block].store(claimFirst && block == 0 ? InUse : Free);
+
+		return i * BLOCKS_PER_SLAB;
+	}
+
+	jassertfalse;
+	return -1;
+}
+
+bool DelayMemoryPool::TrimSlab(Slab& slab)
+{
+	// Lock every block first, so none can be acquired while the memory goes away
+	for (int block = 0; block < BLOCKS_PER_SLAB; block++)
+	{
+		int expected = Free;
+		if (slab.state[block].compare_exchange_strong(expected, Locked))
+			continue;
+
+		while (--block >= 0)
+			slab.state[block].store(Free);
+
+		return false;
+	}
+
+	slab.sizeClass.store(-1);
+	slab.data.free();
+	return true;
+}
+
+void DelayMemoryPool::run()
+{
+	// Short enough that instances waking up dry or prepared in a burst wait only a block or two
+	while (!threadShouldExit())
+	{
+		Maintain();
+		wait(FILL_INTERVAL_MS);
+	}
+}
+
+void DelayMemoryPool::Maintain()
+{
+	const juce::ScopedLock sl(m_lock);
+
+	int freeBlocks[N_SIZE_CLASSES] = {};
+	int usedBlocks[N_SIZE_CLASSES] = {};
+
+	for (const auto& slab : m_slabs)
+	{
+		const int sizeClass = slab.sizeClass.load();
+		if (sizeClass < 0)
+			continue;
+
+		for (const auto& state : slab.state)
+		{
+			const int blockState = state.load();
+			if (blockState == Free)
+				freeBlocks[sizeClass]++;
+			else if (blockState == InUse)
+				usedBlocks[sizeClass]++;
+		}
+	}
+
+	for (int sizeClass = 0; sizeClass < N_SIZE_CLASSES; sizeClass++)
+	{
+		const int waiting = m_waiting[sizeClass].load();
+
+		// Spares outlive the last user of a class by SPARE_TIMEOUT_MS, then its slabs go back
+		if (usedBlocks[sizeClass] > 0 || waiting > 0)
+			m_spareTicks[sizeClass] = SPARE_TIMEOUT_MS / FILL_INTERVAL_MS;
+		else if (m_spareTicks[sizeClass] > 0)
+			m_spareTicks[sizeClass]--;
+
+		// Blocks taken over roughly the last RATE_WINDOW_MS, so a burst of instances being
+		// prepared, or waking on the same transport start, finds the reserve grown ahead of it
+		const float decay = (float)FILL_INTERVAL_MS / RATE_WINDOW_MS;
+		m_takeRate[sizeClass] += m_taken[sizeClass].exchange(0) - m_takeRate[sizeClass] * decay;
+
+		const int spares = juce::jlimit(SPARE_BLOCKS, MAX_SPARE_BLOCKS, (int)std::ceil(m_takeRate[sizeClass]));
+
+		// A bounded reserve, plus a block for each instance already waking up dry.
+		// Hibernating instances hold nothing, their slabs are trimmed like any other
+		const int target = (m_spareTicks[sizeClass] > 0 ? spares : 0) + waiting;
+
+		// Reserve ahead, so instance creation and wake-up find a block ready
+		while (freeBlocks[sizeClass] < target)
+		{
+			if (AllocateSlab(sizeClass, false) < 0)
+				break;
+
+			freeBlocks[sizeClass] += BLOCKS_PER_SLAB;
+		}
+
+		// Hand idle slabs beyond the spares back to the system
+		for (auto& slab : m_slabs)
+		{
+			if (freeBlocks[sizeClass] - BLOCKS_PER_SLAB < target)
+				break;
+
+			if (slab.sizeClass.load() == sizeClass && TrimSlab(slab))
+				freeBlocks[sizeClass] -= BLOCKS_PER_SLAB;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    DelayMemoryPool.h
+    Created: 18 Oct 2026
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Process-wide slab allocator for delay memory, shared through
+    juce::SharedResourcePointer. Requests are rounded up to quarter-octave
+    size classes; each slab holds BLOCKS_PER_SLAB pre-faulted blocks of one
+    class. A pool thread keeps a bounded reserve ready for each class used
+    within SPARE_TIMEOUT_MS, sized by how many blocks were taken in about
+    the last RATE_WINDOW_MS, and trims every other free slab, including
+    those of hibernating instances. Acquire and Release are lock-free and
+    never allocate. Blocks come back with stale contents, every user clears
+    or primes its arena.
+*/
+class DelayMemoryPool : private juce::Thread
+{
+public:
+	static const int MIN_BLOCK_SIZE = 4096;
+	static const int N_SIZE_CLASSES = 60;
+	static const int BLOCKS_PER_SLAB = 4;
+	static const int MAX_SLABS = 256;
+	static const int SPARE_BLOCKS = 2;
+	static const int MAX_SPARE_BLOCKS = 16;
+	static const int FILL_INTERVAL_MS = 10;
+	static const int RATE_WINDOW_MS = 1000;
+	static const int SPARE_TIMEOUT_MS = 10000;
+
+	struct Occupancy
+	{
+		int slabs = 0;
+		int blocks = 0;
+		int inUse = 0;
+		int waiting = 0;
+		juce::int64 missedBlocks = 0;
+		juce::int64 bytes = 0;
+	};
+
+	DelayMemoryPool();
+	~DelayMemoryPool() override;
+
+	// Not realtime safe, allocates and faults in a slab if no free block fits.
+	// Only for callers that cannot wait, such as offline rendering
+	int Allocate(int size);
+
+	// Realtime safe, takes a spare block or returns -1. A caller that misses while it has
+	// signal passes its input through dry for that block, counts it and retries on the next;
+	// registering with Wait once gets it a block within FILL_INTERVAL_MS
+	int Acquire(int size);
+	void CountMissedBlock();
+	void Wait(int size);
+	void StopWaiting(int size);
+	void Release(int block);
+	float* GetData(int block) const;
+
+	Occupancy GetOccupancy() const;
+
+	static int GetClassSize(int sizeClass);
+	static int GetSizeClass(int size);
+
+private:
+	enum State { Locked, Free, InUse };
+
+	struct Slab
+	{
+		std::atomic<int> sizeClass{ -1 };
+		std::atomic<int> state[BLOCKS_PER_SLAB];
+		juce::HeapBlock<float> data;
+	};
+
+	void run() override;
+	void Maintain();
+	int TakeBlock(int sizeClass);
+	int AllocateSlab(int sizeClass, bool claimFirst);
+	bool TrimSlab(Slab& slab);
+
+	Slab m_slabs[MAX_SLABS];
+	std::atomic<int> m_waiting[N_SIZE_CLASSES];
+	std::atomic<int> m_taken[N_SIZE_CLASSES];
+	std::atomic<juce::int64> m_missedBlocks{ 0 };
+	float m_takeRate[N_SIZE_CLASSES] = {};
+	int m_spareTicks[N_SIZE_CLASSES] = {};
+	juce::CriticalSection m_lock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayMemoryPool)
+};
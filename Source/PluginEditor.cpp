@@ -39,11 +39,38 @@ DifuserAudioProcessorEditor::DifuserAudioProcessorEditor (DifuserAudioProcessor&
 		m_sliderAttachment[i].reset(new SliderAttachment(valueTreeState, DifuserAudioProcessor::paramsNames[i], slider));
 	}
 
-	setSize((int)(SLIDER_WIDTH * 0.01f * SCALE * N_SLIDERS_COUNT), (int)(SLIDER_WIDTH * 0.01f * SCALE));
+	for (int i = 0; i < N_TOGGLES_COUNT; i++)
+	{
+		auto& toggle = m_toggles[i];
+		const auto& name = DifuserAudioProcessor::paramsNames[N_SLIDERS_COUNT + i];
+
+		//Toggle
+		toggle.setButtonText(name);
+		addAndMakeVisible(toggle);
+		m_toggleAttachment[i].reset(new ButtonAttachment(valueTreeState, name, toggle));
+	}
+
+	//Delay memory pool
+	m_occupancyLabel.setJustificationType(juce::Justification::centredRight);
+	addAndMakeVisible(m_occupancyLabel);
+	timerCallback();
+	startTimer(OCCUPANCY_REFRESH_MS);
+
+	setSize((int)(SLIDER_WIDTH * 0.01f * SCALE * N_SLIDERS_COUNT), (int)(SLIDER_WIDTH * 0.01f * SCALE) + BUTTON_HEIGHT);
 }
 
 DifuserAudioProcessorEditor::~DifuserAudioProcessorEditor()
 {
+	stopTimer();
+}
+
+void DifuserAudioProcessorEditor::timerCallback()
+{
+	// Shared by all instances in this process
+	const auto occupancy = audioProcessor.GetDelayMemoryOccupancy();
+
+	m_occupancyLabel.setText("Pool " + juce::String(occupancy.inUse) + "/" + juce::String(occupancy.blocks) + " blocks, "
+		+ juce::String(occupancy.bytes / (1024 * 1024)) + " MB, " + juce::String(occupancy.missedBlocks) + " dry", juce::dontSendNotification);
 }
 
 //==============================================================================
@@ -68,4 +95,12 @@ void DifuserAudioProcessorEditor::resized()
 		rectangles[i].removeFromBottom((int)(LABEL_OFFSET * 0.01f * SCALE));
 		m_labels[i].setBounds(rectangles[i]);
 	}
+
+	// Toggles
+	for (int i = 0; i < N_TOGGLES_COUNT; ++i)
+	{
+		m_toggles[i].setBounds(i * width, height, width, BUTTON_HEIGHT);
+	}
+
+	m_occupancyLabel.setBounds(N_TOGGLES_COUNT * width, height, getWidth() - N_TOGGLES_COUNT * width, BUTTON_HEIGHT);
 }
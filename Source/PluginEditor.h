@@ -14,25 +14,32 @@
 //==============================================================================
 /**
 */
-class DifuserAudioProcessorEditor  : public juce::AudioProcessorEditor
+class DifuserAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                     private juce::Timer
 {
 public:
     DifuserAudioProcessorEditor (DifuserAudioProcessor&, juce::AudioProcessorValueTreeState&);
     ~DifuserAudioProcessorEditor() override;
 
-	static const int N_SLIDERS_COUNT = 5;
+	static const int N_SLIDERS_COUNT = 6;
+	static const int N_TOGGLES_COUNT = 2;
 	static const int SCALE = 70;
 	static const int LABEL_OFFSET = 25;
 	static const int SLIDER_WIDTH = 200;
 	static const int HUE = 20;
+	static const int BUTTON_HEIGHT = 30;
+	static const int OCCUPANCY_REFRESH_MS = 1000;
 
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
 
 	typedef juce::AudioProcessorValueTreeState::SliderAttachment SliderAttachment;
+	typedef juce::AudioProcessorValueTreeState::ButtonAttachment ButtonAttachment;
 
 private:
+	void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     DifuserAudioProcessor& audioProcessor;
@@ -43,5 +50,10 @@ private:
 	juce::Slider m_sliders[N_SLIDERS_COUNT] = {};
 	std::unique_ptr<SliderAttachment> m_sliderAttachment[N_SLIDERS_COUNT] = {};
 
+	juce::ToggleButton m_toggles[N_TOGGLES_COUNT] = {};
+	std::unique_ptr<ButtonAttachment> m_toggleAttachment[N_TOGGLES_COUNT] = {};
+
+	juce::Label m_occupancyLabel;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DifuserAudioProcessorEditor)
 };
@@ -18,7 +18,12 @@ void CircularBuffer::Init(int size)
 {
 	m_head = 0;
 	m_size = size;
-	m_buffer.setSize(1, size);
+}
+
+void CircularBuffer::SetData(float* data)
+{
+	m_head = 0;
+	m_buffer.setDataToReferTo(&data, 1, m_size);
 }
 
 void CircularBuffer::Clear()
@@ -27,17 +32,34 @@ void CircularBuffer::Clear()
 	m_buffer.clear();
 }
 
+void CircularBuffer::Fill(float sample, int length)
+{
+	// The length samples written last, the only ones a read can reach before they are overwritten
+	const int start = m_head - length;
+	float* data = m_buffer.getWritePointer(0);
+
+	if (start >= 0)
+	{
+		juce::FloatVectorOperations::fill(data + start, sample, length);
+	}
+	else
+	{
+		juce::FloatVectorOperations::fill(data, sample, m_head);
+		juce::FloatVectorOperations::fill(data + start + m_size, sample, -start);
+	}
+}
+
 float CircularBuffer::ReadDelay(float sample)
 {
+	// Split the delay before indexing, so the result does not depend on where the head is
 	const int bufferSize = m_size;
-	const float readIdx = m_head + bufferSize - sample;
+	const int delay = static_cast<int>(sample);
+	const float weight = 1.f - (sample - delay);
 
-	const int flr = static_cast<int>(readIdx);
-	const int iPrev = flr < bufferSize ? flr : flr - bufferSize;
-	int iNext = flr + 1;
-	iNext = iNext < bufferSize ? iNext : iNext - bufferSize;
+	int iNext = m_head - delay;
+	iNext = iNext < 0 ? iNext + bufferSize : iNext;
+	const int iPrev = iNext > 0 ? iNext - 1 : bufferSize - 1;
 
-	const float weight = readIdx - flr;
 	return m_buffer.getSample(0, iPrev) * (1.f - weight) + m_buffer.getSample(0, iNext) * weight;
 }
 
@@ -47,6 +69,13 @@ float CircularBuffer::ReadFactor(float factor)
 	return ReadDelay(sample);
 }
 
+int CircularBuffer::GetReadLength(float factor) const
+{
+	// ReadFactor interpolates between the samples written delay and delay + 1 steps ago
+	const int delay = static_cast<int>(2.0f + m_size * factor * 0.98f);
+	return juce::jmin(delay + 2, m_size);
+}
+
 //==============================================================================
 DelayLineDifuser::DelayLineDifuser()
 {
@@ -74,6 +103,18 @@ void DelayLineDifuser::Init(float delayFactor, int sampleRate)
 	}
 }
 
+void DelayLineDifuser::SetArena(float* arena)
+{
+	for (int stage = 0; stage < N_STAGES; stage++)
+	{
+		for (int delayLine = 0; delayLine < N_DELAY_LINES; delayLine++)
+		{
+			m_buffer[stage][delayLine].SetData(arena);
+			arena += m_buffer[stage][delayLine].GetSize();
+		}
+	}
+}
+
 float DelayLineDifuser::ProcessSample(float inSample, float factor, int density)
 {
 	// Clamp density
@@ -90,8 +131,8 @@ float DelayLineDifuser::ProcessSample(float inSample, float factor, int density)
 
 	delayIn[0] = 0.8f * inSample;
 	delayIn[1] = 1.2f * inSample;
-	delayIn[2] = -inSample - 0.1f;
-	delayIn[3] = -inSample + 0.1f;
+	delayIn[2] = -inSample - DC_OFFSET;
+	delayIn[3] = -inSample + DC_OFFSET;
 
 	for (int stage = 0; stage < densitySafe; stage++)
 	{
@@ -123,6 +164,546 @@ void DelayLineDifuser::Clear()
 	}
 }
 
+void DelayLineDifuser::Prime(float factor, int density)
+{
+	// On silent input every line settles to a constant, set by the DC offset fed to the first stage.
+	// Only what the current settings read is written, the rest is overwritten before it is reached
+	const int densitySafe = juce::jlimit(2, N_STAGES, density);
+	float delayIn[N_DELAY_LINES] = { 0.0f, 0.0f, -DC_OFFSET, DC_OFFSET };
+
+	for (int stage = 0; stage < densitySafe; stage++)
+	{
+		for (int delayLine = 0; delayLine < N_DELAY_LINES; delayLine++)
+		{
+			auto& buffer = m_buffer[stage][delayLine];
+			buffer.Fill(delayIn[delayLine], buffer.GetReadLength(factor));
+		}
+
+		const float delayOut[N_DELAY_LINES] = { delayIn[0], delayIn[1], delayIn[2], delayIn[3] };
+
+		delayIn[0] = delayOut[0] + delayOut[1] + delayOut[2] + delayOut[3];
+		delayIn[1] = delayOut[0] - delayOut[1] + delayOut[2] - delayOut[3];
+		delayIn[2] = delayOut[0] + delayOut[1] - delayOut[2] - delayOut[3];
+		delayIn[3] = delayOut[0] - delayOut[1] - delayOut[2] + delayOut[3];
+	}
+}
+
+void DelayLineDifuser::Skip(juce::int64 samples)
+{
+	for (int stage = 0; stage < N_STAGES; stage++)
+	{
+		for (int delayLine = 0; delayLine < N_DELAY_LINES; delayLine++)
+		{
+			m_buffer[stage][delayLine].Skip(samples);
+		}
+	}
+}
+
+int DelayLineDifuser::GetMemoryLength() const
+{
+	// Stages are feed-forward, so the output depends only on the last
+	// sum of the longest line per stage input samples
+	int memoryLength = 0;
+
+	for (int stage = 0; stage < N_STAGES; stage++)
+	{
+		int stageLength = 0;
+
+		for (int delayLine = 0; delayLine < N_DELAY_LINES; delayLine++)
+		{
+			stageLength = juce::jmax(stageLength, m_buffer[stage][delayLine].GetSize());
+		}
+
+		memoryLength += stageLength;
+	}
+
+	return memoryLength;
+}
+
+int DelayLineDifuser::GetMemoryLength(float factor, int density) const
+{
+	// Only the first density stages are used, each reading no further back than factor allows
+	const int densitySafe = juce::jlimit(2, N_STAGES, density);
+	int memoryLength = 0;
+
+	for (int stage = 0; stage < densitySafe; stage++)
+	{
+		int stageLength = 0;
+
+		for (int delayLine = 0; delayLine < N_DELAY_LINES; delayLine++)
+		{
+			stageLength = juce::jmax(stageLength, m_buffer[stage][delayLine].GetReadLength(factor));
+		}
+
+		memoryLength += stageLength;
+	}
+
+	return memoryLength;
+}
+
+int DelayLineDifuser::GetArenaSize() const
+{
+	int arenaSize = 0;
+
+	for (int stage = 0; stage < N_STAGES; stage++)
+	{
+		for (int delayLine = 0; delayLine < N_DELAY_LINES; delayLine++)
+		{
+			arenaSize += m_buffer[stage][delayLine].GetSize();
+		}
+	}
+
+	return arenaSize;
+}
+
+//==============================================================================
+LazyDifuser::LazyDifuser()
+{
+}
+
+void LazyDifuser::Init(int memoryLength)
+{
+	m_memoryLength = memoryLength;
+
+	// Long enough to replay the whole memory and fade in before the input that woke the
+	// network reaches it. Catching up gains one sample less per sample than it replays
+	m_maxLookahead = (memoryLength + CATCH_UP_RATE - 2) / (CATCH_UP_RATE - 1) + FADE_SAMPLES;
+	m_lookahead = 0;
+	m_history.Init(memoryLength + m_maxLookahead + 1);
+	m_lengthFactor = -1.0f;
+	Clear();
+}
+
+void LazyDifuser::AllocateHistory()
+{
+	m_historyData.malloc(m_history.GetSize());
+	m_history.SetData(m_historyData.get());
+}
+
+void LazyDifuser::FreeHistory()
+{
+	m_historyData.free();
+}
+
+void LazyDifuser::Clear()
+{
+	// Only the lookahead is read back before it was written
+	if (m_lookahead > 0)
+		m_history.Fill(0.0f, m_lookahead);
+
+	m_lag = 0;
+	m_quietSamples = 0;
+	m_fade = FADE_SAMPLES;
+	m_asleep = false;
+}
+
+int LazyDifuser::GetReplayLength(const DelayLineDifuser& difuser, float factor, int density)
+{
+	if (factor != m_lengthFactor || density != m_lengthDensity)
+	{
+		m_lengthFactor = factor;
+		m_lengthDensity = density;
+		m_replayLength = juce::jmin(difuser.GetMemoryLength(factor, density), m_memoryLength);
+	}
+
+	return m_replayLength;
+}
+
+void LazyDifuser::SkipUnread(DelayLineDifuser& difuser, int replayLength)
+{
+	// Anything older than the network reads back gets overwritten by the replay anyway,
+	// so those samples only move the write heads along
+	if (m_lag > replayLength)
+	{
+		difuser.Skip(m_lag - replayLength);
+		m_lag = replayLength;
+	}
+}
+
+float LazyDifuser::ProcessSample(DelayLineDifuser& difuser, float inSample, float factor, int density, float headroomdB)
+{
+	m_history.WriteSample(inSample);
+
+	// The network runs m_lookahead samples behind the input. m_lag counts samples
+	// of that delayed stream not yet fed to it, including the current one
+	m_lag++;
+
+	const float drySample = ReadDelayed();
+	const int replayLength = GetReplayLength(difuser, factor, density);
+
+	// Headroom is measured on the input, so the samples still in the lookahead
+	// are all quiet once it stayed low for longer than the lookahead
+	m_quietSamples = headroomdB < -(WAKE_MARGIN_DB + HYSTERESIS_DB) ? juce::jmin(m_quietSamples + 1, m_lookahead + 1) : 0;
+
+	if (m_asleep)
+	{
+		SkipUnread(difuser, replayLength);
+
+		if (headroomdB < -WAKE_MARGIN_DB)
+		{
+			m_replayFactor = factor;
+			m_replayDensity = density;
+			return drySample;
+		}
+
+		m_asleep = false;
+	}
+	else if (m_lag == 1 && m_quietSamples > m_lookahead)
+	{
+		m_replayFactor = factor;
+		m_replayDensity = density;
+		m_fade = 0;
+		m_asleep = true;
+		return drySample;
+	}
+
+	// Catch up at a capped rate, older samples with the parameters they were skipped under
+	for (int step = 0; step < CATCH_UP_RATE && m_lag > 1; step++)
+	{
+		difuser.ProcessSample(m_history.ReadSample(m_lookahead + m_lag), m_replayFactor, m_replayDensity);
+		m_lag--;
+	}
+
+	// Still below threshold while catching up and fading in, as long as the lookahead covers both
+	if (m_lag > 1)
+	{
+		m_fade = 0;
+		return drySample;
+	}
+
+	m_lag = 0;
+	const float out = difuser.ProcessSample(drySample, factor, density);
+
+	if (m_fade == FADE_SAMPLES)
+		return out;
+
+	m_fade++;
+	return drySample + (out - drySample) * m_fade / FADE_SAMPLES;
+}
+
+void LazyDifuser::SkipSample(DelayLineDifuser& difuser, float inSample, float factor, int density)
+{
+	// The network falls behind and catches up from history, at the capped rate, when it is needed again
+	m_history.WriteSample(inSample);
+	m_lag++;
+
+	SkipUnread(difuser, GetReplayLength(difuser, factor, density));
+	m_asleep = true;
+	m_replayFactor = factor;
+	m_replayDensity = density;
+}
+
+//==============================================================================
+LoopCache::LoopCache()
+{
+}
+
+void LoopCache::Init(int capacity, int memoryLength, int bridgeLength)
+{
+	m_capacity = capacity;
+	m_memoryLength = memoryLength;
+	m_input.malloc(capacity);
+	m_output.malloc(capacity);
+	m_state.calloc(capacity);
+	m_touchedBegin = capacity;
+	m_touchedEnd = 0;
+	m_numEdges = 0;
+	m_active = false;
+	m_serving = false;
+
+	m_bridgeLength = bridgeLength;
+	m_bridgeInput.malloc(bridgeLength);
+	m_bridgeOutput.malloc(bridgeLength);
+	EndBridge();
+}
+
+void LoopCache::Reset()
+{
+	if (!m_active)
+		return;
+
+	// However serving ends, the path it was on is needed before the cache is cleared
+	StopServing();
+
+	// Only the range written since the last reset needs clearing, not the whole capacity
+	if (m_touchedEnd > m_touchedBegin)
+		juce::zeromem(m_state.get() + m_touchedBegin, (size_t)(m_touchedEnd - m_touchedBegin));
+
+	m_touchedBegin = m_capacity;
+	m_touchedEnd = 0;
+	m_numEdges = 0;
+	m_active = false;
+}
+
+void LoopCache::Restart(juce::int64 origin)
+{
+	Reset();
+
+	m_active = true;
+	m_origin = origin;
+	m_tracked = 0;
+	m_verified = 0;
+	m_landing = false;
+	m_overflow = false;
+	m_pathIndex = -1;
+	m_horizonLength = 0;
+}
+
+void LoopCache::AddEdge(juce::int64 from, juce::int64 to)
+{
+	if (m_numEdges == MAX_EDGES)
+		Restart(to);
+
+	m_edges[m_numEdges].from = from;
+	m_edges[m_numEdges].to = to;
+	m_numEdges++;
+
+	const int index = GetIndex(to);
+	m_state[index] |= LANDING;
+	Touch(index);
+	m_landing = true;
+
+	// The path may have led elsewhere from here
+	m_horizonLength = 0;
+}
+
+void LoopCache::Touch(int index)
+{
+	m_touchedBegin = juce::jmin(m_touchedBegin, index);
+	m_touchedEnd = juce::jmax(m_touchedEnd, index + 1);
+}
+
+int LoopCache::GetIndex(juce::int64 position) const
+{
+	const juce::int64 index = position - m_origin;
+	return index >= 0 && index < m_capacity ? (int)index : -1;
+}
+
+int LoopCache::GetNextIndex(int index, bool& landing) const
+{
+	// Along the latest jump the host made from here, otherwise on to the next sample
+	const juce::int64 position = m_origin + index;
+
+	for (int edge = m_numEdges - 1; edge >= 0; edge--)
+	{
+		if (m_edges[edge].from == position)
+		{
+			landing = true;
+			return GetIndex(m_edges[edge].to);
+		}
+	}
+
+	landing = false;
+	return index + 1 < m_capacity ? index + 1 : -1;
+}
+
+bool LoopCache::IsServable(int index, bool landing) const
+{
+	// Reached contiguously, a landing restarts the cache instead
+	return index >= 0 && (m_state[index] & SERVABLE) != 0 && (landing || (m_state[index] & LANDING) == 0);
+}
+
+void LoopCache::AdvanceHorizon(int index)
+{
+	// The horizon moves along with the host while it follows the path, and on by a few entries per sample
+	if (index == m_pathIndex && m_horizonLength > 0)
+	{
+		m_horizonLength--;
+	}
+	else
+	{
+		m_horizonIndex = index;
+		m_horizonLength = 0;
+	}
+
+	for (int step = 0; step < HORIZON_STEPS && m_horizonLength < m_bridgeLength; step++)
+	{
+		bool landing = false;
+		const int next = GetNextIndex(m_horizonIndex, landing);
+		if (!IsServable(next, landing))
+			break;
+
+		m_horizonIndex = next;
+		m_horizonLength++;
+	}
+
+	bool landing = false;
+	m_pathIndex = GetNextIndex(index, landing);
+}
+
+void LoopCache::StopServing()
+{
+	if (!m_serving)
+		return;
+
+	m_serving = false;
+
+	// The cached pass continued along the path, so its inputs and outputs from there on
+	// bridge the skipped network back to exact output, whatever the host does next
+	int index = m_servedIndex;
+	int size = 0;
+
+	while (size < m_bridgeLength)
+	{
+		bool landing = false;
+		index = GetNextIndex(index, landing);
+		if (!IsServable(index, landing))
+			break;
+
+		m_bridgeInput[size] = m_input[index];
+		m_bridgeOutput[size] = m_output[index];
+		size++;
+	}
+
+	m_bridgeSize = size;
+	m_bridgeRead = 0;
+	m_bridgeFactor = m_factor;
+	m_bridgeDensity = m_density;
+}
+
+bool LoopCache::ReadBridge(float& inSample, float& outSample)
+{
+	if (!IsBridging())
+		return false;
+
+	inSample = m_bridgeInput[m_bridgeRead];
+	outSample = m_bridgeOutput[m_bridgeRead];
+	m_bridgeRead++;
+	return true;
+}
+
+void LoopCache::EndBridge()
+{
+	m_bridgeSize = 0;
+	m_bridgeRead = 0;
+}
+
+void LoopCache::BeginBlock(juce::int64 position, float factor, int density)
+{
+	// Anything cached was computed with other parameters
+	if (!m_active || factor != m_factor || density != m_density)
+	{
+		Restart(position);
+		m_position = position;
+		m_factor = factor;
+		m_density = density;
+		return;
+	}
+
+	if (position == m_position)
+		return;
+
+	// Host jumped, usually a loop wrapping around
+	const juce::int64 from = m_position - 1;
+	m_position = position;
+
+	const int index = GetIndex(position);
+
+	// Off the path serving follows, so it stops before the edges change
+	bool landing = false;
+	if (m_serving && (index < 0 || GetNextIndex(m_servedIndex, landing) != index))
+		StopServing();
+
+	for (int edge = 0; edge < m_numEdges; edge++)
+	{
+		if (m_edges[edge].to != position)
+			continue;
+
+		// Same jump as on an earlier pass, so the context carries over
+		if (m_edges[edge].from == from && !m_overflow)
+			m_landing = true;
+		else
+		{
+			Restart(position);
+			AddEdge(from, position);
+		}
+		return;
+	}
+
+	// Landing outside the cached range, usually a loop start before where caching began,
+	// or on samples first reached another way changes their context
+	if (index < 0 || m_overflow || m_state[index] != 0)
+		Restart(position);
+
+	AddEdge(from, position);
+}
+
+bool LoopCache::Read(float inSample, float& outSample)
+{
+	const juce::int64 position = m_position++;
+	const bool landing = m_landing;
+	m_landing = false;
+	m_index = -1;
+
+	int index = GetIndex(position);
+	if (index < 0)
+	{
+		// Loops longer than the cache are not served
+		if (position >= m_origin + m_capacity)
+			m_overflow = true;
+
+		StopServing();
+		m_tracked = 0;
+		m_verified = 0;
+		m_pathIndex = -1;
+		m_horizonLength = 0;
+		return false;
+	}
+
+	// Reached contiguously where a jump used to land, or the input changed
+	const juce::uint8 state = m_state[index];
+	if (((state & LANDING) != 0 && !landing) || ((state & SEEN) != 0 && m_input[index] != inSample))
+	{
+		Restart(position);
+		index = 0;
+	}
+
+	AdvanceHorizon(index);
+	m_tracked = juce::jmin(m_tracked + 1, m_memoryLength + 1);
+
+	if ((m_state[index] & SEEN) != 0)
+	{
+		m_verified = juce::jmin(m_verified + 1, m_memoryLength + 1);
+
+		// The whole network memory matched the pass this output was computed on, and the path
+		// ahead is cached for as long as the network would take to catch up if serving stopped
+		if ((m_state[index] & SERVABLE) != 0 && m_verified > m_memoryLength && m_horizonLength >= m_bridgeLength && !IsBridging())
+		{
+			outSample = m_output[index];
+			m_serving = true;
+			m_servedIndex = index;
+			return true;
+		}
+	}
+	else
+	{
+		m_verified = 0;
+	}
+
+	StopServing();
+	m_index = index;
+	m_pendingInput = inSample;
+	return false;
+}
+
+void LoopCache::Write(float outSample, bool exact)
+{
+	if (m_index < 0)
+		return;
+
+	// Only outputs computed from a fully tracked network memory, by a network in sync or bridged back to it, may be served later
+	const bool servable = exact && m_tracked > m_memoryLength;
+
+	m_input[m_index] = m_pendingInput;
+	m_output[m_index] = outSample;
+	m_state[m_index] = (juce::uint8)((m_state[m_index] & LANDING) | SEEN | (servable ? SERVABLE : 0));
+	Touch(m_index);
+
+	// A short loop may have this entry on the path ahead
+	if (!servable)
+		m_horizonLength = 0;
+}
+
 //==============================================================================
 EnvelopeFollower::EnvelopeFollower()
 {
@@ -139,22 +720,172 @@ void EnvelopeFollower::SetCoef(float attackTime, float releaseTime)
 	m_ReleaseCoef = expf(-1000.0f / (releaseTime * m_SampleRate));
 }
 
-float EnvelopeFollower::process(float in)
+void EnvelopeFollower::process(const float* const* in, float* const* out, int channels, int samples)
 {
-	const float tmp = fabs(in);
-	if (tmp > m_Envelope)
+	jassert(channels <= MAX_CHANNELS);
+
+#if JUCE_USE_SIMD && (JUCE_INTEL || JUCE_ARM)
+	// A single channel would leave three lanes idle and still pay for the transposes
+	if (channels > 1)
 	{
-		return m_Envelope = tmp + m_AttackCoef * (m_Envelope - tmp);
+		processLanes(in, out, channels, samples);
+		return;
 	}
-	else
+#endif
+
+	for (int channel = 0; channel < channels; channel++)
+		processChannel(in[channel], out[channel], channel, samples);
+}
+
+void EnvelopeFollower::processChannel(const float* in, float* out, int channel, int samples)
+{
+	// For one channel the predicted branch keeps the dependency chain through envelope
+	// shortest, blends measured 1.5 to 2 times slower
+	const float attackCoef = m_AttackCoef;
+	const float releaseCoef = m_ReleaseCoef;
+	float envelope = m_Envelope[channel];
+
+	for (int sample = 0; sample < samples; sample++)
+	{
+		const float tmp = fabsf(in[sample]);
+
+		if (tmp > envelope)
+			envelope = tmp + attackCoef * (envelope - tmp);
+		else
+			envelope = tmp + releaseCoef * (envelope - tmp);
+
+		out[sample] = envelope;
+	}
+
+	m_Envelope[channel] = envelope;
+}
+
+#if JUCE_USE_SIMD && (JUCE_INTEL || JUCE_ARM)
+void EnvelopeFollower::processLanes(const float* const* in, float* const* out, int channels, int samples)
+{
+	// Keep state and coefficients in registers for the whole block
+	Lanes envelope = Load(m_Envelope, MAX_CHANNELS);
+	const Lanes zero = Expand(0.0f);
+	const Lanes attackCoef = Expand(m_AttackCoef);
+	const Lanes releaseCoef = Expand(m_ReleaseCoef);
+
+	for (int sample = 0; sample < samples; sample += BLOCK_SIZE)
+	{
+		const int frames = juce::jmin(BLOCK_SIZE, samples - sample);
+
+		// Contiguous samples of one channel per register, transposed to one sample of every channel
+		Lanes block[BLOCK_SIZE];
+		for (int channel = 0; channel < MAX_CHANNELS; channel++)
+			block[channel] = channel < channels ? Load(in[channel] + sample, frames) : zero;
+
+		Transpose(block);
+
+		for (int frame = 0; frame < frames; frame++)
+		{
+			envelope = Follow(block[frame], envelope, attackCoef, releaseCoef);
+			block[frame] = envelope;
+		}
+
+		Transpose(block);
+
+		for (int channel = 0; channel < channels; channel++)
+			Store(block[channel], out[channel] + sample, frames);
+	}
+
+	Store(envelope, m_Envelope, MAX_CHANNELS);
+}
+
+EnvelopeFollower::Lanes EnvelopeFollower::Load(const float* data, int samples)
+{
+	// Channel data carries no alignment guarantee, and the last block of a buffer may be short
+	if (samples < BLOCK_SIZE)
 	{
-		return m_Envelope = tmp + m_ReleaseCoef * (m_Envelope - tmp);
+		float padded[BLOCK_SIZE] = {};
+		std::copy(data, data + samples, padded);
+		return Load(padded, BLOCK_SIZE);
 	}
+
+#if JUCE_INTEL
+	return _mm_loadu_ps(data);
+#else
+	return vld1q_f32(data);
+#endif
 }
 
+void EnvelopeFollower::Store(Lanes lanes, float* data, int samples)
+{
+	if (samples < BLOCK_SIZE)
+	{
+		float padded[BLOCK_SIZE];
+		Store(lanes, padded, BLOCK_SIZE);
+		std::copy(padded, padded + samples, data);
+		return;
+	}
+
+#if JUCE_INTEL
+	_mm_storeu_ps(data, lanes);
+#else
+	vst1q_f32(data, lanes);
+#endif
+}
+
+#if JUCE_INTEL
+EnvelopeFollower::Lanes EnvelopeFollower::Expand(float value)
+{
+	return _mm_set1_ps(value);
+}
+
+void EnvelopeFollower::Transpose(Lanes (&block)[BLOCK_SIZE])
+{
+	_MM_TRANSPOSE4_PS(block[0], block[1], block[2], block[3]);
+}
+
+EnvelopeFollower::Lanes EnvelopeFollower::Follow(Lanes in, Lanes envelope, Lanes attackCoef, Lanes releaseCoef)
+{
+	const __m128 tmp = _mm_andnot_ps(_mm_set1_ps(-0.0f), in);
+	const __m128 difference = _mm_sub_ps(envelope, tmp);
+	const __m128 attack = _mm_add_ps(tmp, _mm_mul_ps(attackCoef, difference));
+	const __m128 release = _mm_add_ps(tmp, _mm_mul_ps(releaseCoef, difference));
+
+	// Attack where rising, release otherwise, blended with a mask instead of a branch.
+	// Blending the results keeps the compare off the dependency chain through envelope
+	const __m128 rising = _mm_cmpgt_ps(tmp, envelope);
+	return _mm_or_ps(_mm_and_ps(rising, attack), _mm_andnot_ps(rising, release));
+}
+#else
+EnvelopeFollower::Lanes EnvelopeFollower::Expand(float value)
+{
+	return vdupq_n_f32(value);
+}
+
+void EnvelopeFollower::Transpose(Lanes (&block)[BLOCK_SIZE])
+{
+	const float32x4x2_t low = vtrnq_f32(block[0], block[1]);
+	const float32x4x2_t high = vtrnq_f32(block[2], block[3]);
+
+	block[0] = vcombine_f32(vget_low_f32(low.val[0]), vget_low_f32(high.val[0]));
+	block[1] = vcombine_f32(vget_low_f32(low.val[1]), vget_low_f32(high.val[1]));
+	block[2] = vcombine_f32(vget_high_f32(low.val[0]), vget_high_f32(high.val[0]));
+	block[3] = vcombine_f32(vget_high_f32(low.val[1]), vget_high_f32(high.val[1]));
+}
+
+EnvelopeFollower::Lanes EnvelopeFollower::Follow(Lanes in, Lanes envelope, Lanes attackCoef, Lanes releaseCoef)
+{
+	const float32x4_t tmp = vabsq_f32(in);
+	const float32x4_t difference = vsubq_f32(envelope, tmp);
+	const float32x4_t attack = vaddq_f32(tmp, vmulq_f32(attackCoef, difference));
+	const float32x4_t release = vaddq_f32(tmp, vmulq_f32(releaseCoef, difference));
+
+	// Attack where rising, release otherwise, blended with a mask instead of a branch.
+	// Blending the results keeps the compare off the dependency chain through envelope
+	return vbslq_f32(vcgtq_f32(tmp, envelope), attack, release);
+}
+#endif
+#endif
+
 //==============================================================================
 
-const std::string DifuserAudioProcessor::paramsNames[] = { "Lenght", "Density", "Threshold", "Mix", "Volume" };
+const std::string DifuserAudioProcessor::paramsNames[] = { "Lenght", "Density", "Threshold", "Mix", "Volume", "Hibernate", "Lazy", "Cache" };
 
 //==============================================================================
 DifuserAudioProcessor::DifuserAudioProcessor()
@@ -174,10 +905,19 @@ DifuserAudioProcessor::DifuserAudioProcessor()
 	thresholdParameter		= apvts.getRawParameterValue(paramsNames[2]);
 	mixParameter			= apvts.getRawParameterValue(paramsNames[3]);
 	volumeParameter			= apvts.getRawParameterValue(paramsNames[4]);
+	hibernateParameter		= apvts.getRawParameterValue(paramsNames[5]);
+	lazyParameter			= apvts.getRawParameterValue(paramsNames[6]);
+	cacheParameter			= apvts.getRawParameterValue(paramsNames[7]);
 }
 
 DifuserAudioProcessor::~DifuserAudioProcessor()
 {
+	cancelPendingUpdate();
+
+	if (m_arenaBlock >= 0)
+		m_delayMemoryPool->Release(m_arenaBlock);
+
+	StopWaiting();
 }
 
 //==============================================================================
@@ -245,27 +985,233 @@ void DifuserAudioProcessor::changeProgramName (int index, const juce::String& ne
 //==============================================================================
 void DifuserAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+	m_sampleRate = (int)(sampleRate);
+
 	// Maximum diffusion lenght
 	float difusionLenght = 5.0f;
 	m_delayLineDifuser[0].Init(difusionLenght, (int)(sampleRate));
-	m_delayLineDifuser[0].Clear();
 	m_delayLineDifuser[1].Init(difusionLenght, (int)(sampleRate));
-	m_delayLineDifuser[1].Clear();
-
-	m_envelopeFollower[0].Init((int)(sampleRate));
-	m_envelopeFollower[1].Init((int)(sampleRate));
+	m_bridgeDifuser[0].Init(difusionLenght, (int)(sampleRate));
+	m_bridgeDifuser[1].Init(difusionLenght, (int)(sampleRate));
 
 	const float attack = 10;
 	const float release = 200;
 
-	m_envelopeFollower[0].SetCoef(attack, release);
-	m_envelopeFollower[1].SetCoef(attack, release);
+	m_lazyDifuser[0].Init(m_delayLineDifuser[0].GetMemoryLength());
+	m_lazyDifuser[1].Init(m_delayLineDifuser[1].GetMemoryLength());
+
+	// Delay memory comes from the process-wide pool, so it can be handed back while hibernating
+	if (m_arenaBlock >= 0)
+		m_delayMemoryPool->Release(m_arenaBlock);
+
+	StopWaiting();
+
+	m_arenaSize = m_delayLineDifuser[0].GetArenaSize() + m_delayLineDifuser[1].GetArenaSize();
+
+	// Never allocates here, so preparing many instances at once costs the same for each.
+	// With the reserve used up, start out like a hibernating instance and wake once signal arrives
+	m_arenaBlock = m_delayMemoryPool->Acquire(m_arenaSize);
+	m_hibernating = m_arenaBlock < 0;
+	m_silentSamples = 0;
+
+	if (!m_hibernating)
+	{
+		SetArena(m_delayMemoryPool->GetData(m_arenaBlock));
+		m_delayLineDifuser[0].Clear();
+		m_delayLineDifuser[1].Clear();
+	}
+
+	m_envelopeFollower.Init((int)(sampleRate));
+	m_envelopeFollower.SetCoef(attack, release);
+	m_lookaheadFollower.Init((int)(sampleRate));
+	m_lookaheadFollower.SetCoef(attack, release);
+
+	// Also the chunk size processBlock works in, so it must not be empty
+	m_difuseBuffer.setSize(2, juce::jmax(samplesPerBlock, 1));
+	m_envelopeBuffer.setSize(2, juce::jmax(samplesPerBlock, 1));
+	m_dryBuffer.setSize(2, juce::jmax(samplesPerBlock, 1));
+
+	// History and loop cache memory are only taken while a mode using them is enabled
+	cancelPendingUpdate();
+	m_historyReady = false;
+	m_loopCacheReady = false;
+	m_historyMode = -1;
+
+	const bool lazy = lazyParameter->load() > 0.5f;
+
+	if (lazy || cacheParameter->load() > 0.5f)
+	{
+		InitHistory();
+	}
+	else
+	{
+		m_lazyDifuser[0].FreeHistory();
+		m_lazyDifuser[1].FreeHistory();
+	}
+
+	m_lazyReady = lazy;
+	setLatencySamples(lazy ? m_lazyDifuser[0].GetLookahead() : 0);
+
+	if (cacheParameter->load() > 0.5f)
+	{
+		InitLoopCache();
+	}
+	else
+	{
+		m_loopCache[0].Init(0, 0, 0);
+		m_loopCache[1].Init(0, 0, 0);
+		m_bridgeArena.free();
+	}
 }
 
 void DifuserAudioProcessor::releaseResources()
 {
-	m_delayLineDifuser[0].Clear();
-	m_delayLineDifuser[1].Clear();
+	if (m_arenaBlock >= 0)
+		Hibernate();
+}
+
+void DifuserAudioProcessor::SetArena(float* arena)
+{
+	for (int channel = 0; channel < 2; channel++)
+	{
+		m_delayLineDifuser[channel].SetArena(arena);
+		arena += m_delayLineDifuser[channel].GetArenaSize();
+	}
+}
+
+bool DifuserAudioProcessor::WakeUp(float factor, int density)
+{
+	// On a miss the block stays dry, the pool counts it and has a block ready shortly.
+	// Offline renders cannot skip anything, so they allocate instead
+	m_arenaBlock = m_delayMemoryPool->Acquire(m_arenaSize);
+	if (m_arenaBlock < 0 && isNonRealtime())
+		m_arenaBlock = m_delayMemoryPool->Allocate(m_arenaSize);
+
+	if (m_arenaBlock < 0)
+	{
+		m_delayMemoryPool->CountMissedBlock();
+
+		if (!m_waiting)
+		{
+			m_delayMemoryPool->Wait(m_arenaSize);
+			m_waiting = true;
+		}
+
+		return false;
+	}
+
+	StopWaiting();
+
+	// Resume where a network left running through the silence would be, not from zero
+	SetArena(m_delayMemoryPool->GetData(m_arenaBlock));
+	m_delayLineDifuser[0].Prime(factor, density);
+	m_delayLineDifuser[1].Prime(factor, density);
+	m_lazyDifuser[0].Clear();
+	m_lazyDifuser[1].Clear();
+	m_historyMode = -1;
+	m_hibernating = false;
+	m_silentSamples = 0;
+	return true;
+}
+
+void DifuserAudioProcessor::StopWaiting()
+{
+	// Counted once per instance, not per failed wake-up attempt
+	if (m_waiting)
+		m_delayMemoryPool->StopWaiting(m_arenaSize);
+
+	m_waiting = false;
+}
+
+void DifuserAudioProcessor::Hibernate()
+{
+	// The block goes back for good, the pool only keeps a bounded reserve for wake-ups
+	m_delayMemoryPool->Release(m_arenaBlock);
+	m_arenaBlock = -1;
+	m_hibernating = true;
+
+	if (m_loopCacheReady)
+	{
+		for (auto& loopCache : m_loopCache)
+		{
+			loopCache.Reset();
+			loopCache.EndBridge();
+		}
+	}
+}
+
+void DifuserAudioProcessor::handleAsyncUpdate()
+{
+	if (m_sampleRate == 0)
+		return;
+
+	const bool lazy = lazyParameter->load() > 0.5f;
+	const bool cache = cacheParameter->load() > 0.5f;
+
+	if ((lazy || cache) && !m_historyReady)
+		InitHistory();
+
+	if (cache && !m_loopCacheReady)
+		InitLoopCache();
+
+	// The lookahead delays the whole output, so the host has to know before it is used
+	if (lazy != m_lazyReady)
+	{
+		setLatencySamples(lazy ? m_lazyDifuser[0].GetLookahead() : 0);
+		m_lazyReady = lazy;
+	}
+}
+
+void DifuserAudioProcessor::InitHistory()
+{
+	m_lazyDifuser[0].AllocateHistory();
+	m_lazyDifuser[1].AllocateHistory();
+	m_historyReady = true;
+}
+
+void DifuserAudioProcessor::InitLoopCache()
+{
+	// A bridge has to last until the network caught up, as long as the lazy lookahead
+	for (int channel = 0; channel < 2; channel++)
+		m_loopCache[channel].Init((int)(m_loopCacheSeconds.load() * m_sampleRate), m_delayLineDifuser[channel].GetMemoryLength(), m_lazyDifuser[channel].GetLookahead());
+
+	m_bridgeArena.malloc(m_bridgeDifuser[0].GetArenaSize() + m_bridgeDifuser[1].GetArenaSize());
+	m_bridgeDifuser[0].SetArena(m_bridgeArena.get());
+	m_bridgeDifuser[1].SetArena(m_bridgeArena.get() + m_bridgeDifuser[0].GetArenaSize());
+
+	m_loopCacheReady = true;
+}
+
+float DifuserAudioProcessor::Bridge(int channel, float inSample, float outSample)
+{
+	auto& loopCache = m_loopCache[channel];
+	auto& bridgeDifuser = m_bridgeDifuser[channel];
+
+	// Caught up, the network gives the same output from here on
+	if (!m_lazyDifuser[channel].IsBehind())
+	{
+		loopCache.EndBridge();
+		return outSample;
+	}
+
+	const float factor = loopCache.GetBridgeFactor();
+	const int density = loopCache.GetBridgeDensity();
+
+	// Drained, the network outputs a constant set by its DC offset
+	if (loopCache.IsBridgeStart())
+	{
+		bridgeDifuser.Prime(factor, density);
+		m_bridgeOffset[channel] = bridgeDifuser.ProcessSample(0.0f, factor, density);
+	}
+
+	float cachedInput = 0.0f;
+	float cachedOutput = 0.0f;
+	if (!loopCache.ReadBridge(cachedInput, cachedOutput))
+		return outSample;
+
+	// The network is affine, so input departing from the cached pass only adds the
+	// response of a drained network to the difference
+	return cachedOutput + bridgeDifuser.ProcessSample(inSample - cachedInput, factor, density) - m_bridgeOffset[channel];
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -303,39 +1249,232 @@ void DifuserAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce
 	const float volume = juce::Decibels::decibelsToGain(volumeParameter->load());
 	const float thresholddB = thresholdParameter->load();
 	const float threshold = juce::Decibels::decibelsToGain(thresholddB);
+	const float hibernateTime = hibernateParameter->load();
+	const bool lazyEnabled = lazyParameter->load() > 0.5f;
+	const bool cacheEnabled = cacheParameter->load() > 0.5f;
 	
 	// Mics constants
 	const float mixInverse = 1.0f - mix;
 	const int channels = getTotalNumOutputChannels();
 	const int samples = buffer.getNumSamples();
+
+	// History is allocated, and the lookahead latency reported, on the message thread
+	if (lazyEnabled != m_lazyReady || ((lazyEnabled || cacheEnabled) && !m_historyReady) || (cacheEnabled && !m_loopCacheReady))
+		triggerAsyncUpdate();
+
+	const bool lazy = m_lazyReady.load() && m_historyReady.load();
+
+	// Hibernation, after the network has drained and the input stayed silent for hibernateTime
+	const bool silent = buffer.getMagnitude(0, samples) < SILENCE_GAIN;
+
+	if (m_hibernating)
+	{
+		if (silent || !WakeUp(factor, density))
+		{
+			buffer.applyGain(volume);
+			return;
+		}
+	}
+	else if (silent && hibernateTime > 0.0f)
+	{
+		m_silentSamples += samples;
+
+		// The lookahead still holds input the network has not seen
+		const int lookahead = lazy ? m_lazyDifuser[0].GetLookahead() : 0;
+
+		if (m_silentSamples > m_delayLineDifuser[0].GetMemoryLength() + lookahead + (int)(hibernateTime * m_sampleRate))
+		{
+			Hibernate();
+			buffer.applyGain(volume);
+			return;
+		}
+	}
+	else
+	{
+		m_silentSamples = 0;
+	}
 	
-	for (int channel = 0; channel < channels; ++channel)
+	// Loop cache, keyed by host position while playing; hosts not reporting a position get no cache
+	bool playing = false;
+	juce::int64 position = 0;
+	double loopSeconds = 0.0;
+
+	if (auto* playHead = getPlayHead())
+	{
+		if (const auto positionInfo = playHead->getPosition())
+		{
+			if (const auto timeInSamples = positionInfo->getTimeInSamples())
+			{
+				playing = positionInfo->getIsPlaying();
+				position = *timeInSamples;
+			}
+
+			const auto loopPoints = positionInfo->getLoopPoints();
+			const auto bpm = positionInfo->getBpm();
+
+			if (positionInfo->getIsLooping() && loopPoints && bpm && *bpm > 0.0)
+				loopSeconds = (loopPoints->ppqEnd - loopPoints->ppqStart) * 60.0 / *bpm;
+		}
+	}
+
+	// Sized to the host loop where it reports one, so long loops fit and short ones take less memory.
+	// Reallocated on the message thread, and only with the network in sync, so no serving or bridge is cut short
+	if (cacheEnabled && loopSeconds > 0.0 && m_loopCacheReady && !m_lazyDifuser[0].IsBehind() && !m_lazyDifuser[1].IsBehind())
+	{
+		const float seconds = (float)loopSeconds + LoopCache::CACHE_MARGIN_SECONDS;
+		const int capacity = (int)(seconds * m_sampleRate);
+		const int allocated = m_loopCache[0].GetCapacity();
+
+		if (capacity > allocated || capacity < allocated / 2)
+		{
+			m_loopCacheSeconds = seconds;
+			m_loopCacheReady = false;
+			triggerAsyncUpdate();
+		}
+	}
+
+	const bool loopCacheReady = m_loopCacheReady.load();
+	const bool cache = loopCacheReady && m_historyReady.load() && cacheEnabled && playing && !lazy;
+
+	// Stopping may end serving, the bridge back to the network keeps the history in use
+	bool bridging = false;
+
+	if (loopCacheReady)
+	{
+		for (auto& loopCache : m_loopCache)
+		{
+			if (!cache)
+				loopCache.Reset();
+
+			bridging = bridging || loopCache.IsBridging();
+		}
+	}
+
+	// Without either mode the network runs directly, otherwise through the history.
+	// Entering the history, or moving the network in or out of the lookahead, starts it over
+	const int historyMode = lazy ? 2 : cache || bridging ? 1 : 0;
+	if (historyMode != m_historyMode)
+	{
+		m_historyMode = historyMode;
+
+		for (int channel = 0; channel < 2; channel++)
+		{
+			if (loopCacheReady)
+				m_loopCache[channel].EndBridge();
+
+			// A network left behind while asleep would resume from stale memory, so it
+			// resumes from its drained state instead, as after hibernating
+			if (m_lazyDifuser[channel].IsBehind())
+				m_delayLineDifuser[channel].Prime(factor, density);
+
+			m_lazyDifuser[channel].SetLookahead(lazy);
+			m_lazyDifuser[channel].Clear();
+		}
+	}
+
+	// Hosts may exceed the announced block size, so work in chunks of the scratch buffers
+	const int chunkSize = m_difuseBuffer.getNumSamples();
+
+	for (int start = 0; start < samples; start += chunkSize)
 	{
-		auto* channelBuffer = buffer.getWritePointer(channel);
+		const int chunk = juce::jmin(chunkSize, samples - start);
+
+		// Detect on the input, a lookahead ahead of the network, so it can sleep while clearly
+		// below threshold and be back in sync before a louder input reaches it
+		if (lazy)
+		{
+			const float* inputBuffer[EnvelopeFollower::MAX_CHANNELS] = {};
+			for (int channel = 0; channel < channels; ++channel)
+				inputBuffer[channel] = buffer.getReadPointer(channel, start);
 
-		auto& delayLineDifuser = m_delayLineDifuser[channel];
-		auto& envelopeFollower = m_envelopeFollower[channel];
+			m_lookaheadFollower.process(inputBuffer, m_envelopeBuffer.getArrayOfWritePointers(), channels, chunk);
+		}
 
-		for (int sample = 0; sample < samples; ++sample)
+		for (int channel = 0; channel < channels; ++channel)
 		{
-			const float in = channelBuffer[sample];
+			const auto* channelBuffer = buffer.getReadPointer(channel, start);
+			const auto* envelopeBuffer = m_envelopeBuffer.getReadPointer(channel);
+			auto* difuseBuffer = m_difuseBuffer.getWritePointer(channel);
+			auto* dryBuffer = m_dryBuffer.getWritePointer(channel);
 
-			float inDifuse = delayLineDifuser.ProcessSample(in, factor, density);
+			auto& delayLineDifuser = m_delayLineDifuser[channel];
+			auto& lazyDifuser = m_lazyDifuser[channel];
+			auto& loopCache = m_loopCache[channel];
 
-			float envelopedB  = juce::Decibels::gainToDecibels(envelopeFollower.process(inDifuse));
+			if (cache)
+				loopCache.BeginBlock(position + start, factor, density);
 
-			// Calculate mix ratio
-			float dynamicMix = 0.0f;
-			if (envelopedB > thresholddB)
+			for (int sample = 0; sample < chunk; ++sample)
 			{
-				dynamicMix = fminf((envelopedB - thresholddB) / 12.0f, 1.0f);
+				const float in = channelBuffer[sample];
+				float inDifuse = 0.0f;
+
+				if (historyMode == 0)
+				{
+					inDifuse = delayLineDifuser.ProcessSample(in, factor, density);
+				}
+				else if (cache && loopCache.Read(in, inDifuse))
+				{
+					lazyDifuser.SkipSample(delayLineDifuser, in, factor, density);
+				}
+				else
+				{
+					// Zero headroom keeps the network always running
+					const float headroomdB = lazy ? juce::Decibels::gainToDecibels(envelopeBuffer[sample]) - thresholddB : 0.0f;
+
+					// The bridge is exact, so the network takes over from it without a fade
+					const bool bridged = historyMode == 1 && loopCache.IsBridging();
+					if (bridged)
+						lazyDifuser.CancelFade();
+
+					inDifuse = lazyDifuser.ProcessSample(delayLineDifuser, in, factor, density, headroomdB);
+
+					if (bridged)
+						inDifuse = Bridge(channel, in, inDifuse);
+
+					if (cache)
+						loopCache.Write(inDifuse, lazyDifuser.IsInSync() || loopCache.IsBridging());
+				}
+
+				difuseBuffer[sample] = inDifuse;
+
+				if (lazy)
+					dryBuffer[sample] = lazyDifuser.ReadDelayed();
 			}
+		}
 
-			// Apply dynamic mix ratio
-			const float inDifuseDynamic  = dynamicMix * inDifuse + (1.0f - dynamicMix) * in;
+		// Lazy mode mixes the input delayed by the lookahead, with its own envelope
+		if (lazy)
+			m_envelopeFollower.process(m_dryBuffer.getArrayOfReadPointers(), m_envelopeBuffer.getArrayOfWritePointers(), channels, chunk);
+		else
+			m_envelopeFollower.process(m_difuseBuffer.getArrayOfReadPointers(), m_envelopeBuffer.getArrayOfWritePointers(), channels, chunk);
 
-			// Static mix
-			channelBuffer[sample]  = volume * (mix * inDifuseDynamic + mixInverse * in);
+		for (int channel = 0; channel < channels; ++channel)
+		{
+			auto* channelBuffer = buffer.getWritePointer(channel, start);
+			const auto* envelopeBuffer = m_envelopeBuffer.getReadPointer(channel);
+			const auto* difuseBuffer = m_difuseBuffer.getReadPointer(channel);
+			const auto* dryBuffer = m_dryBuffer.getReadPointer(channel);
+
+			for (int sample = 0; sample < chunk; ++sample)
+			{
+				const float in = lazy ? dryBuffer[sample] : channelBuffer[sample];
+				const float inDifuse = difuseBuffer[sample];
+				const float envelopedB = juce::Decibels::gainToDecibels(envelopeBuffer[sample]);
+
+				// Calculate mix ratio
+				float dynamicMix = 0.0f;
+				if (envelopedB > thresholddB)
+				{
+					dynamicMix = fminf((envelopedB - thresholddB) / 12.0f, 1.0f);
+				}
+
+				// Apply dynamic mix ratio
+				const float inDifuseDynamic  = dynamicMix * inDifuse + (1.0f - dynamicMix) * in;
+
+				// Static mix
+				channelBuffer[sample]  = volume * (mix * inDifuseDynamic + mixInverse * in);
+			}
 		}
 	}
 }
@@ -379,6 +1518,9 @@ juce::AudioProcessorValueTreeState::ParameterLayout DifuserAudioProcessor::creat
 	layout.add(std::make_unique<juce::AudioParameterFloat>(paramsNames[2], paramsNames[2], NormalisableRange<float>(-60.0f,  0.0f, 0.01f, 1.0f), -30.0f));
 	layout.add(std::make_unique<juce::AudioParameterFloat>(paramsNames[3], paramsNames[3], NormalisableRange<float>(  0.0f,  1.0f, 0.01f, 1.0f),   0.5f));
 	layout.add(std::make_unique<juce::AudioParameterFloat>(paramsNames[4], paramsNames[4], NormalisableRange<float>(-12.0f, 12.0f,  0.1f, 1.0f),   0.0f));
+	layout.add(std::make_unique<juce::AudioParameterFloat>(paramsNames[5], paramsNames[5], NormalisableRange<float>(  0.0f, 60.0f,  0.1f, 1.0f),   0.0f));
+	layout.add(std::make_unique<juce::AudioParameterBool>(paramsNames[6], paramsNames[6], false));
+	layout.add(std::make_unique<juce::AudioParameterBool>(paramsNames[7], paramsNames[7], false));
 
 	return layout;
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DelayMemoryPool.h"
 
 //==============================================================================
 class CircularBuffer
@@ -17,6 +18,7 @@ public:
 	CircularBuffer();
 
 	void Init(int size);
+	void SetData(float* data);
 	void WriteSample(float sample)
 	{
 		m_buffer.setSample(0, m_head, sample);
@@ -27,8 +29,20 @@ public:
 	{
 		return m_buffer.getSample(0, m_head);
 	}
+	float ReadSample(int delay) const
+	{
+		const int idx = m_head - delay;
+		return m_buffer.getSample(0, idx < 0 ? idx + m_size : idx);
+	}
+	void Skip(juce::int64 samples)
+	{
+		m_head = (int)((m_head + samples % m_size) % m_size);
+	}
+	int GetSize() const { return m_size; }
+	int GetReadLength(float factor) const;
 	float ReadDelay(float sample);
 	float ReadFactor(float factor);
+	void Fill(float sample, int length);
 	void Clear();
 
 protected:
@@ -42,30 +56,183 @@ class DelayLineDifuser
 {
 	static const int N_DELAY_LINES = 4;
 	static const int N_STAGES = 8;
+	static constexpr float DC_OFFSET = 0.1f;
 public:
 	DelayLineDifuser();
 
 	void Init(float delayFactor, int sampleRate);
+	void SetArena(float* arena);
 	float ProcessSample(float inSample, float factor, int density);
+	void Skip(juce::int64 samples);
+	void Prime(float factor, int density);
 	void Clear();
+	int GetMemoryLength() const;
+	int GetMemoryLength(float factor, int density) const;
+	int GetArenaSize() const;
 
 private:
 	CircularBuffer m_buffer[N_STAGES][N_DELAY_LINES];
 };
 
+//==============================================================================
+class LazyDifuser
+{
+	static constexpr float WAKE_MARGIN_DB = 12.0f;
+	static constexpr float HYSTERESIS_DB = 6.0f;
+	static const int CATCH_UP_RATE = 8;
+	static const int FADE_SAMPLES = 64;
+public:
+	LazyDifuser();
+
+	void Init(int memoryLength);
+	void AllocateHistory();
+	void FreeHistory();
+	int GetLookahead() const { return m_maxLookahead; }
+	void SetLookahead(bool enabled) { m_lookahead = enabled ? m_maxLookahead : 0; }
+	float ProcessSample(DelayLineDifuser& difuser, float inSample, float factor, int density, float headroomdB);
+	void SkipSample(DelayLineDifuser& difuser, float inSample, float factor, int density);
+	float ReadDelayed() const { return m_history.ReadSample(m_lookahead + 1); }
+	bool IsInSync() const { return m_lag == 0 && m_fade == FADE_SAMPLES; }
+	bool IsBehind() const { return m_lag > 0; }
+	void CancelFade() { m_fade = FADE_SAMPLES; }
+	void Clear();
+
+private:
+	int GetReplayLength(const DelayLineDifuser& difuser, float factor, int density);
+	void SkipUnread(DelayLineDifuser& difuser, int replayLength);
+
+	CircularBuffer m_history;
+	juce::HeapBlock<float> m_historyData;
+	int m_memoryLength = 0;
+	int m_maxLookahead = 0;
+	int m_lookahead = 0;
+	int m_quietSamples = 0;
+	int m_lag = 0;
+	float m_replayFactor = 0.0f;
+	int m_replayDensity = 0;
+	float m_lengthFactor = -1.0f;
+	int m_lengthDensity = 0;
+	int m_replayLength = 0;
+	int m_fade = FADE_SAMPLES;
+	bool m_asleep = false;
+};
+
+//==============================================================================
+class LoopCache
+{
+	static const int MAX_EDGES = 8;
+	static const int HORIZON_STEPS = 2;
+	enum { SEEN = 1, SERVABLE = 2, LANDING = 4 };
+public:
+	// For hosts not reporting their loop, otherwise the loop length plus a margin
+	static const int CACHE_SECONDS = 32;
+	static const int CACHE_MARGIN_SECONDS = 1;
+
+	LoopCache();
+
+	void Init(int capacity, int memoryLength, int bridgeLength);
+	void Reset();
+	void BeginBlock(juce::int64 position, float factor, int density);
+	bool Read(float inSample, float& outSample);
+	void Write(float outSample, bool exact);
+	int GetCapacity() const { return m_capacity; }
+	bool IsBridging() const { return m_bridgeRead < m_bridgeSize; }
+	bool IsBridgeStart() const { return m_bridgeRead == 0; }
+	bool ReadBridge(float& inSample, float& outSample);
+	void EndBridge();
+	float GetBridgeFactor() const { return m_bridgeFactor; }
+	int GetBridgeDensity() const { return m_bridgeDensity; }
+
+private:
+	struct Edge
+	{
+		juce::int64 from = 0;
+		juce::int64 to = 0;
+	};
+
+	void Restart(juce::int64 origin);
+	void AddEdge(juce::int64 from, juce::int64 to);
+	void Touch(int index);
+	int GetIndex(juce::int64 position) const;
+	int GetNextIndex(int index, bool& landing) const;
+	bool IsServable(int index, bool landing) const;
+	void AdvanceHorizon(int index);
+	void StopServing();
+
+	juce::HeapBlock<float> m_input;
+	juce::HeapBlock<float> m_output;
+	juce::HeapBlock<juce::uint8> m_state;
+	Edge m_edges[MAX_EDGES];
+	int m_numEdges = 0;
+	int m_capacity = 0;
+	int m_memoryLength = 0;
+	int m_touchedBegin = 0;
+	int m_touchedEnd = 0;
+	juce::int64 m_origin = 0;
+	juce::int64 m_position = 0;
+	float m_factor = 0.0f;
+	int m_density = 0;
+	int m_tracked = 0;
+	int m_verified = 0;
+	int m_index = -1;
+	float m_pendingInput = 0.0f;
+	bool m_active = false;
+	bool m_landing = false;
+	bool m_overflow = false;
+
+	// Where the path the host took so far leads next, and how far ahead of it every entry is servable
+	int m_pathIndex = -1;
+	int m_horizonIndex = -1;
+	int m_horizonLength = 0;
+	int m_servedIndex = -1;
+	bool m_serving = false;
+
+	juce::HeapBlock<float> m_bridgeInput;
+	juce::HeapBlock<float> m_bridgeOutput;
+	int m_bridgeLength = 0;
+	int m_bridgeSize = 0;
+	int m_bridgeRead = 0;
+	float m_bridgeFactor = 0.0f;
+	int m_bridgeDensity = 0;
+};
+
 //==============================================================================
 class EnvelopeFollower
 {
 public:
+	// One channel per lane of a 128-bit register, whatever width juce::dsp::SIMDRegister has in this build
+	static const int MAX_CHANNELS = 4;
+
 	EnvelopeFollower();
 
 	void Init(int sampleRate);
 	void SetCoef(float attackTime, float releaseTime);
-	float process(float in);
+	void process(const float* const* in, float* const* out, int channels, int samples);
 
 protected:
+	void processChannel(const float* in, float* out, int channel, int samples);
+
+#if JUCE_USE_SIMD && JUCE_INTEL
+	using Lanes = __m128;
+#elif JUCE_USE_SIMD && JUCE_ARM
+	using Lanes = float32x4_t;
+#endif
+
+#if JUCE_USE_SIMD && (JUCE_INTEL || JUCE_ARM)
+	// Blocks are as many samples long as there are lanes, so they transpose in place
+	static const int BLOCK_SIZE = MAX_CHANNELS;
+
+	void processLanes(const float* const* in, float* const* out, int channels, int samples);
+
+	static Lanes Expand(float value);
+	static Lanes Load(const float* data, int samples);
+	static void Store(Lanes lanes, float* data, int samples);
+	static void Transpose(Lanes (&block)[BLOCK_SIZE]);
+	static Lanes Follow(Lanes in, Lanes envelope, Lanes attackCoef, Lanes releaseCoef);
+#endif
+
 	int  m_SampleRate = 0;
-	float m_Envelope = 0.0f;
+	float m_Envelope[MAX_CHANNELS] = {};
 	float m_AttackCoef = 0.0f;
 	float m_ReleaseCoef = 0.0f;
 };
@@ -73,7 +240,8 @@ protected:
 //==============================================================================
 /**
 */
-class DifuserAudioProcessor  : public juce::AudioProcessor
+class DifuserAudioProcessor  : public juce::AudioProcessor,
+                               private juce::AsyncUpdater
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
@@ -123,6 +291,8 @@ public:
 
 	APVTS apvts{ *this, nullptr, "Parameters", createParameterLayout() };
 
+	DelayMemoryPool::Occupancy GetDelayMemoryOccupancy() const { return m_delayMemoryPool->GetOccupancy(); }
+
 private:
     //==============================================================================
 	std::atomic<float>* difusionLenghtParameter = nullptr;
@@ -130,9 +300,51 @@ private:
 	std::atomic<float>* thresholdParameter = nullptr;
 	std::atomic<float>* mixParameter = nullptr;
 	std::atomic<float>* volumeParameter = nullptr;
+	std::atomic<float>* hibernateParameter = nullptr;
+	std::atomic<float>* lazyParameter = nullptr;
+	std::atomic<float>* cacheParameter = nullptr;
 
 	DelayLineDifuser m_delayLineDifuser[2] = {};
-	EnvelopeFollower m_envelopeFollower[2] = {};
+	LazyDifuser m_lazyDifuser[2] = {};
+	EnvelopeFollower m_envelopeFollower;
+	EnvelopeFollower m_lookaheadFollower;
+
+	juce::AudioBuffer<float> m_difuseBuffer;
+	juce::AudioBuffer<float> m_envelopeBuffer;
+	juce::AudioBuffer<float> m_dryBuffer;
+
+	static constexpr float SILENCE_GAIN = 0.000001f;
+
+	void SetArena(float* arena);
+	bool WakeUp(float factor, int density);
+	void Hibernate();
+	void StopWaiting();
+
+	void handleAsyncUpdate() override;
+	void InitHistory();
+	void InitLoopCache();
+	float Bridge(int channel, float inSample, float outSample);
+
+	juce::SharedResourcePointer<DelayMemoryPool> m_delayMemoryPool;
+	int m_arenaBlock = -1;
+	int m_arenaSize = 0;
+	int m_sampleRate = 0;
+	int m_silentSamples = 0;
+	bool m_hibernating = false;
+	bool m_waiting = false;
+
+	std::atomic<bool> m_historyReady{ false };
+	std::atomic<bool> m_lazyReady{ false };
+	int m_historyMode = -1;
+
+	LoopCache m_loopCache[2] = {};
+	std::atomic<bool> m_loopCacheReady{ false };
+	std::atomic<float> m_loopCacheSeconds{ (float)LoopCache::CACHE_SECONDS };
+
+	// Takes the difference between the input and the cached pass a bridge continues from
+	DelayLineDifuser m_bridgeDifuser[2] = {};
+	juce::HeapBlock<float> m_bridgeArena;
+	float m_bridgeOffset[2] = {};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DifuserAudioProcessor)
 };